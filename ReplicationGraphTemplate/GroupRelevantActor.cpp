@@ -0,0 +1,50 @@
+// Copyright (c) 2025 Aida Drogan, SilverCord-VR Studio
+
+#include "GroupRelevantActor.h"
+#include "Engine/NetDriver.h"
+#include "MyReplicationGraph.h"
+
+// Sets default values
+AGroupRelevantActor::AGroupRelevantActor()
+{
+ 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+	PrimaryActorTick.bCanEverTick = true;
+	bReplicates = true;
+	SetReplicateMovement(false);
+	PrimaryActorTick.bCanEverTick = false;
+
+}
+
+// Called when the game starts or when spawned
+void AGroupRelevantActor::BeginPlay()
+{
+	Super::BeginPlay();
+	
+}
+
+// Called every frame
+void AGroupRelevantActor::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+}
+
+// Updates the group and lets the replication graph move the actor to the new group's list.
+void AGroupRelevantActor::SetReplicationGroup(int32 NewReplicationGroup)
+{
+	if (!HasAuthority() || NewReplicationGroup == ReplicationGroup)
+	{
+		return;
+	}
+
+	const int32 OldReplicationGroup = ReplicationGroup;
+	ReplicationGroup = NewReplicationGroup;
+
+	if (UNetDriver* NetDriver = GetNetDriver())
+	{
+		if (UMyReplicationGraph* RepGraph = NetDriver->GetReplicationDriver<UMyReplicationGraph>())
+		{
+			RepGraph->NotifyActorReplicationGroupChanged(this, OldReplicationGroup, NewReplicationGroup);
+		}
+	}
+}
\ No newline at end of file
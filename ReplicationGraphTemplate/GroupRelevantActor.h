@@ -0,0 +1,39 @@
+// Copyright (c) 2025 Aida Drogan, SilverCord-VR Studio
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "GroupRelevantActor.generated.h"
+
+UCLASS()
+class REPGRAPHTEST_API AGroupRelevantActor : public AActor
+{
+	GENERATED_BODY()
+	
+public:	
+	// Sets default values for this actor's properties
+	AGroupRelevantActor();
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+public:	
+	// Called every frame
+	virtual void Tick(float DeltaTime) override;
+
+	// Returns the replication group (team or squad id) this actor is relevant to.
+	int32 GetReplicationGroup() const { return ReplicationGroup; }
+
+	// Changes the replication group on the server and moves the actor to the new group's list.
+	UFUNCTION(BlueprintCallable, Category = "Replication")
+	void SetReplicationGroup(int32 NewReplicationGroup);
+
+protected:
+	// Team or squad id of the connections this actor is replicated to.
+	// INDEX_NONE means the actor is not replicated to any connection.
+	UPROPERTY(EditAnywhere, Category = "Replication")
+	int32 ReplicationGroup = INDEX_NONE;
+
+};
\ No newline at end of file
@@ -11,11 +11,29 @@
 #include "StaticRepActor.h"
 #include "DormantRepActor.h"
 #include "RelevantAllConnectionsActor.h"
+#include "GroupRelevantActor.h"
+#include "Misc/MemStack.h"
+#include "HAL/MemoryBase.h"
+#include "Engine/NetConnection.h"
+#include "Misc/CommandLine.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 
 void UMyReplicationGraph::ResetGameWorldState()
 {
 	Super::ResetGameWorldState();
-	AlwaysRelevantStreamingLevelActors.Empty();
+
+	for (TPair<FName, FDAStreamingLevelActorList>& LevelActors : AlwaysRelevantStreamingLevelActors)
+	{
+		ActorListPool.Release(LevelActors.Value.ActorList);
+	}
+	AlwaysRelevantStreamingLevelActors.Reset();
+
+	for (TPair<EClassRepPolicy, FDAPooledActorList>& PolicyActors : ReplayActorLists)
+	{
+		ActorListPool.Release(PolicyActors.Value);
+	}
+	ReplayActorLists.Reset();
+	ActorListPool.Release(ReplayAlwaysRelevantActors);
 
 	// Iterate over both active and pending network connections.
 	// This ensures we reset all per-connection replication nodes,
@@ -42,6 +60,18 @@ void UMyReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnectio
 	ConnectionManager->OnClientVisibleLevelNameAdd.AddUObject(Node, &UDAReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityAdd);
 	ConnectionManager->OnClientVisibleLevelNameRemove.AddUObject(Node, &UDAReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityRemove);
 
+	// Replay recording gets the low cost replay profile, live players go through the join warmup.
+	// Replay connections are not tied to the demo net driver, they can also be added to the game net driver.
+	Node->bReplayConnection = bUseReplayConnectionProfile && ConnectionManager->NetConnection != nullptr && ConnectionManager->NetConnection->IsReplay();
+	if (Node->bReplayConnection)
+	{
+		BeginReplayActorLists();
+	}
+	else
+	{
+		Node->BeginJoinWarmup();
+	}
+
 	AddConnectionGraphNode(Node, ConnectionManager);
 }
 
@@ -58,6 +88,7 @@ void UMyReplicationGraph::InitGlobalActorClassSettings()
 	SetRule(AStaticRepActor::StaticClass(), EClassRepPolicy::Spatialize_Static);
 	SetRule(ADormantRepActor::StaticClass(), EClassRepPolicy::Spatialize_Dormancy);
 	SetRule(ARelevantAllConnectionsActor::StaticClass(), EClassRepPolicy::RelevantAllConnections);
+	SetRule(AGroupRelevantActor::StaticClass(), EClassRepPolicy::RelevantGroup);
 
 	TArray<UClass*> ReplicatedClasses;
 	for (TObjectIterator<UClass> Itr; Itr; ++Itr)
@@ -173,16 +204,160 @@ void UMyReplicationGraph::InitGlobalActorClassSettings()
 }
 
 // Initializes global graph nodes for spatialized and always relevant actors.
-// Adds a 2D spatial grid node for dynamic relevance and a static list node for actors always relevant to all connections.
+// Adds a 2D spatial grid node for dynamic relevance, a static list node for actors always relevant to all connections
+// and a group relevancy node for actors relevant to a single team or squad.
 void UMyReplicationGraph::InitGlobalGraphNodes()
 {
-	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode = CreateNewNode<UDAReplicationGraphNode_GridSpatialization2D>();
 	GridNode->CellSize = GridCellSize;
 	GridNode->SpatialBias = FVector2D(SpatialBiasX, SpatialBiasY);
+	GridNode->WarmupChannelBudgetPerFrame = JoinWarmupChannelBudgetPerFrame;
+	GridNode->WarmupMaxFrames = FMath::Max(1, JoinWarmupMaxFrames);
+	GridNode->WarmupTeleportDistance = JoinWarmupTeleportDistance;
+
+	if (ActorListPoolBlockSize > 0)
+	{
+		ActorListPool.BlockSize = ActorListPoolBlockSize;
+	}
+
+	// Only the game net driver is measured, a replay recording graph would double count.
+	bSoakActive = (bSoakTelemetry || FParse::Param(FCommandLine::Get(), TEXT("RepGraphSoak"))) && NetDriver != nullptr && NetDriver->NetDriverName == NAME_GameNetDriver;
+
+	// Lets Scripts/run_repgraph_soak.sh set the length of the run from the command line.
+	FParse::Value(FCommandLine::Get(), TEXT("RepGraphSoakDuration="), SoakDurationSeconds);
+
+	if (bSoakActive || FParse::Param(FCommandLine::Get(), TEXT("RepGraphCountAllocations")))
+	{
+		bCountHeapAllocations = FDAScopedHeapAllocationCounter::InstallHeapAllocationCounting();
+		if (!bCountHeapAllocations)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Heap allocations cannot be counted on this platform, GMalloc is bypassed."));
+		}
+	}
 
 	AddGlobalGraphNode(GridNode);
 	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
 	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	GroupRelevancyNode = CreateNewNode<UDAReplicationGraphNode_GroupRelevancy>();
+	AddGlobalGraphNode(GroupRelevancyNode);
+}
+
+int32 UMyReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	if (!bSoakActive && !bCountHeapAllocations)
+	{
+		return Super::ServerReplicateActors(DeltaSeconds);
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	int32 Result = 0;
+	{
+		FDAScopedHeapAllocationCounter AllocationCounter(NumReplicationHeapAllocations);
+		Result = Super::ServerReplicateActors(DeltaSeconds);
+	}
+
+	if (bSoakActive)
+	{
+		TickSoakTelemetry((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+
+	return Result;
+}
+
+// Logs a sample every SoakSampleInterval seconds. When SoakDurationSeconds is over, memory growth
+// against the baseline and the replication time p99 are checked and the server exits with the result.
+void UMyReplicationGraph::TickSoakTelemetry(double ReplicationMs)
+{
+	const double Now = FPlatformTime::Seconds();
+	if (!SoakTelemetry.bStarted)
+	{
+		SoakTelemetry.Start(Now);
+	}
+
+	if (SoakTelemetry.bFinished)
+	{
+		return;
+	}
+
+	SoakTelemetry.RecordFrame(ReplicationMs);
+
+	const double Elapsed = Now - SoakTelemetry.StartTime;
+
+	// Memory stats are read from /proc on Linux, so they are only queried when they are used.
+	if (!SoakTelemetry.bHasBaseline && Elapsed >= SoakWarmupSeconds)
+	{
+		SoakTelemetry.bHasBaseline = true;
+		SoakTelemetry.BaselineUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+		SoakTelemetry.BaselineActorListPoolAllocations = ActorListPool.NumHeapAllocations;
+		SoakTelemetry.BaselineGatherHeapAllocations = NumGatherHeapAllocations;
+		SoakTelemetry.BaselineReplicationHeapAllocations = NumReplicationHeapAllocations;
+		SoakTelemetry.ResetHistogram();
+	}
+
+	if (Now - SoakTelemetry.LastSampleTime >= FMath::Max(1.f, SoakSampleInterval))
+	{
+		SoakTelemetry.LastSampleTime = Now;
+
+		int32 NumConnections = 0;
+		int32 NumChannels = 0;
+		int64 OutBytesPerSecond = 0;
+		int32 NumActorInfos = 0;
+		for (UNetReplicationGraphConnection* Connection : Connections)
+		{
+			if (UNetConnection* NetConnection = Connection->NetConnection)
+			{
+				++NumConnections;
+				NumChannels += NetConnection->OpenChannels.Num();
+				OutBytesPerSecond += NetConnection->OutBytesPerSecond;
+				NumActorInfos += Connection->ActorInfoMap.Num();
+			}
+		}
+
+		const FDAJoinWarmupStats& WarmupStats = GridNode->GetWarmupStats();
+		UE_LOG(LogTemp, Display, TEXT("Soak t=%.0fs: replication p50 %.1f ms, p99 %.1f ms, max %.1f ms | %d connections, %d channels, %lld B/s per connection, %d actor infos | used memory %.1f MB, list pool allocations %d, heap allocations %lld gather, %lld replication | join warmups %d completed, %d timed out, max %.2f s"),
+			Elapsed, SoakTelemetry.GetPercentileMs(0.5), SoakTelemetry.GetPercentileMs(0.99), SoakTelemetry.MaxReplicationMs,
+			NumConnections, NumChannels, NumConnections > 0 ? OutBytesPerSecond / NumConnections : 0, NumActorInfos,
+			FPlatformMemory::GetStats().UsedPhysical / (1024.0 * 1024.0), ActorListPool.NumHeapAllocations,
+			NumGatherHeapAllocations, NumReplicationHeapAllocations,
+			WarmupStats.NumCompleted, WarmupStats.NumTimedOut, WarmupStats.MaxSeconds);
+	}
+
+	if (SoakDurationSeconds <= 0.f || Elapsed < SoakDurationSeconds)
+	{
+		return;
+	}
+
+	SoakTelemetry.bFinished = true;
+
+	const uint64 UsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	const double MemoryGrowthMB = SoakTelemetry.bHasBaseline ? ((int64)UsedPhysical - (int64)SoakTelemetry.BaselineUsedPhysical) / (1024.0 * 1024.0) : 0.0;
+	const double P99Ms = SoakTelemetry.GetPercentileMs(0.99);
+	const bool bLeak = SoakMaxMemoryGrowthMB > 0.f && MemoryGrowthMB > SoakMaxMemoryGrowthMB;
+	const bool bSlow = SoakMaxP99ReplicationMs > 0.f && P99Ms > SoakMaxP99ReplicationMs;
+
+	// Without a baseline the whole run counts.
+	const int32 NumPoolAllocations = ActorListPool.NumHeapAllocations - SoakTelemetry.BaselineActorListPoolAllocations;
+	const int64 NumGatherAllocations = NumGatherHeapAllocations - SoakTelemetry.BaselineGatherHeapAllocations;
+	const int64 NumReplicationAllocations = NumReplicationHeapAllocations - SoakTelemetry.BaselineReplicationHeapAllocations;
+	const bool bAllocates = bSoakFailOnGatherAllocations && bCountHeapAllocations && (NumPoolAllocations > 0 || NumGatherAllocations > 0);
+
+	UE_LOG(LogTemp, Display, TEXT("Soak finished after %.0fs, %lld frames after warmup: memory growth %.1f MB (limit %.1f), replication p99 %.1f ms (limit %.1f), after warmup: list pool allocations %d, gather heap allocations %lld, replication heap allocations %lld (%.1f per frame)"),
+		Elapsed, SoakTelemetry.NumFrames, MemoryGrowthMB, SoakMaxMemoryGrowthMB, P99Ms, SoakMaxP99ReplicationMs,
+		NumPoolAllocations, NumGatherAllocations, NumReplicationAllocations,
+		SoakTelemetry.NumFrames > 0 ? (double)NumReplicationAllocations / SoakTelemetry.NumFrames : 0.0);
+
+	if (bLeak || bSlow || bAllocates)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Soak FAILED:%s%s%s"), bLeak ? TEXT(" memory leak") : TEXT(""), bSlow ? TEXT(" replication p99 over budget") : TEXT(""),
+			bAllocates ? TEXT(" gather heap allocations in steady state") : TEXT(""));
+	}
+	else
+	{
+		UE_LOG(LogTemp, Display, TEXT("Soak PASSED"));
+	}
+
+	FPlatformMisc::RequestExitWithStatus(false, (bLeak || bSlow || bAllocates) ? 1 : 0);
 }
 
 // Routes a newly replicated actor to the appropriate replication graph node,
@@ -193,6 +368,11 @@ void UMyReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorI
 	UE_LOG(LogTemp, Warning, TEXT("Routing: %s (Policy: %d)"), *GetNameSafe(ActorInfo.Actor), (int32)GetMappingPolicy(ActorInfo.Class));
 
 	EClassRepPolicy MappingPolicy = GetMappingPolicy(ActorInfo.Class);
+	if (bKeepReplayActorLists)
+	{
+		AddReplayActor(ActorInfo, MappingPolicy);
+	}
+
 	switch (MappingPolicy)
 	{
 	case EClassRepPolicy::RelevantAllConnections:
@@ -203,11 +383,15 @@ void UMyReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorI
 		}
 		else
 		{
-			FActorRepListRefView& RepList = AlwaysRelevantStreamingLevelActors.FindOrAdd(ActorInfo.StreamingLevelName);
-			RepList.Add(ActorInfo.Actor);
+			FDAStreamingLevelActorList& LevelActors = AlwaysRelevantStreamingLevelActors.FindOrAdd(ActorInfo.StreamingLevelName);
+			ActorListPool.Add(LevelActors.ActorList, ActorInfo.Actor);
+			LevelActors.bHasDormancyActors |= ActorInfo.Actor->NetDormancy > DORM_Awake;
 		}
 		break;
 	}
+	case EClassRepPolicy::RelevantGroup:
+		GroupRelevancyNode->NotifyAddNetworkActor(ActorInfo);
+		break;
 	case EClassRepPolicy::Spatialize_Static:
 		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
 		break;
@@ -227,6 +411,18 @@ void UMyReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorI
 void UMyReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
 {
 	EClassRepPolicy MappingPolicy = GetMappingPolicy(ActorInfo.Class);
+	if (bKeepReplayActorLists)
+	{
+		if (MappingPolicy == EClassRepPolicy::RelevantAllConnections && ActorInfo.StreamingLevelName == NAME_None)
+		{
+			ActorListPool.RemoveFast(ReplayAlwaysRelevantActors, ActorInfo.Actor);
+		}
+		else if (FDAPooledActorList* ReplayActors = ReplayActorLists.Find(MappingPolicy))
+		{
+			ActorListPool.RemoveFast(*ReplayActors, ActorInfo.Actor);
+		}
+	}
+
 	switch (MappingPolicy)
 	{
 	case EClassRepPolicy::RelevantAllConnections:
@@ -237,11 +433,22 @@ void UMyReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedAct
 		}
 		else
 		{
-			FActorRepListRefView& RepList = AlwaysRelevantStreamingLevelActors.FindOrAdd(ActorInfo.StreamingLevelName);
-			RepList.RemoveFast(ActorInfo.Actor);
+			// Emptied lists stay in the map so the level is kept for connections that see it,
+			// only their storage goes back to the pool.
+			if (FDAStreamingLevelActorList* LevelActors = AlwaysRelevantStreamingLevelActors.Find(ActorInfo.StreamingLevelName))
+			{
+				ActorListPool.RemoveFast(LevelActors->ActorList, ActorInfo.Actor);
+				if (LevelActors->ActorList.Actors.Num() == 0)
+				{
+					LevelActors->bHasDormancyActors = false;
+				}
+			}
 		}
 		break;
 	}
+	case EClassRepPolicy::RelevantGroup:
+		GroupRelevancyNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
 	case EClassRepPolicy::Spatialize_Static:
 		GridNode->RemoveActor_Static(ActorInfo);
 		break;
@@ -256,6 +463,24 @@ void UMyReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedAct
 	}
 }
 
+// Actors that are set dormant after they were routed, e.g. with SetNetDormancy(), move their level to the filtered path.
+// The level stays filtered until it is empty, an actor that wakes up again may still be dormant on some connections.
+void UMyReplicationGraph::NotifyActorDormancyChange(AActor* Actor, ENetDormancy OldDormancyState)
+{
+	Super::NotifyActorDormancyChange(Actor, OldDormancyState);
+
+	if (Actor == nullptr || Actor->NetDormancy <= DORM_Awake || GetMappingPolicy(Actor->GetClass()) != EClassRepPolicy::RelevantAllConnections)
+	{
+		return;
+	}
+
+	const FNewReplicatedActorInfo ActorInfo(Actor);
+	if (FDAStreamingLevelActorList* LevelActors = AlwaysRelevantStreamingLevelActors.Find(ActorInfo.StreamingLevelName))
+	{
+		LevelActors->bHasDormancyActors = true;
+	}
+}
+
 // Initializes replication settings for a specific actor class.
 // - Sets cull distance if spatialized.
 // - Calculates update frequency in frames based on server tick rate and NetUpdateFrequency.
@@ -286,19 +511,230 @@ UDAReplicationGraphNode_AlwaysRelevant_ForConnection* UMyReplicationGraph::GetAl
 		{
 			if (UNetReplicationGraphConnection* GraphConnection = FindOrAddConnectionManager(NetConnection))
 			{
-				for (UReplicationGraphNode* ConnectionNode : GraphConnection->GetConnectionGraphNodes())
+				return GetAlwaysRelevantNode(*GraphConnection);
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+UDAReplicationGraphNode_AlwaysRelevant_ForConnection* UMyReplicationGraph::GetAlwaysRelevantNode(UNetReplicationGraphConnection& ConnectionManager) const
+{
+	for (UReplicationGraphNode* ConnectionNode : ConnectionManager.GetConnectionGraphNodes())
+	{
+		UDAReplicationGraphNode_AlwaysRelevant_ForConnection* Node = Cast<UDAReplicationGraphNode_AlwaysRelevant_ForConnection>(ConnectionNode);
+		if (Node != NULL)
+		{
+			return Node;
+		}
+	}
+
+	return nullptr;
+}
+
+// Group membership is stored on the connection's AlwaysRelevant node,
+// the group relevancy node reads it from there during the gather.
+void UMyReplicationGraph::AddConnectionToReplicationGroup(APlayerController* PlayerController, int32 GroupId)
+{
+	if (UDAReplicationGraphNode_AlwaysRelevant_ForConnection* Node = GetAlwaysRelevantNode(PlayerController))
+	{
+		Node->AddReplicationGroup(GroupId);
+	}
+}
+
+void UMyReplicationGraph::RemoveConnectionFromReplicationGroup(APlayerController* PlayerController, int32 GroupId)
+{
+	if (UDAReplicationGraphNode_AlwaysRelevant_ForConnection* Node = GetAlwaysRelevantNode(PlayerController))
+	{
+		Node->RemoveReplicationGroup(GroupId);
+	}
+}
+
+// Actors that are not in the graph yet pick up their group when they are routed.
+void UMyReplicationGraph::NotifyActorReplicationGroupChanged(AActor* Actor, int32 OldGroupId, int32 NewGroupId)
+{
+	if (Actor == nullptr || GetMappingPolicy(Actor->GetClass()) != EClassRepPolicy::RelevantGroup)
+	{
+		return;
+	}
+
+	if (GlobalActorReplicationInfoMap.Find(Actor) != nullptr)
+	{
+		GroupRelevancyNode->MoveGroupActor(Actor, OldGroupId, NewGroupId);
+	}
+}
+
+// Logs per-connection actor info usage for every connection.
+// Entries are created by the graph for every actor gathered for a connection, whether or not it is sent,
+// so the count reflects what the gather hands to the graph for each connection.
+void UMyReplicationGraph::LogConnectionActorInfoMemory(FOutputDevice& Ar) const
+{
+	// Each entry is a heap allocated FConnectionReplicationActorInfo plus its slot in the actor map.
+	const SIZE_T BytesPerEntry = sizeof(FConnectionReplicationActorInfo) + sizeof(FActorRepListType) + sizeof(TSharedPtr<FConnectionReplicationActorInfo>);
+
+	int32 NumStreamingLevelActors = 0;
+	int32 NumFilteredLevels = 0;
+	int32 NumFilteredLevelActors = 0;
+	for (const TPair<FName, FDAStreamingLevelActorList>& LevelActors : AlwaysRelevantStreamingLevelActors)
+	{
+		NumStreamingLevelActors += LevelActors.Value.ActorList.Actors.Num();
+		if (LevelActors.Value.bHasDormancyActors)
+		{
+			++NumFilteredLevels;
+			NumFilteredLevelActors += LevelActors.Value.ActorList.Actors.Num();
+		}
+	}
+
+	// Filtered levels cost one actor info lookup per actor for every connection that sees them, every frame.
+	Ar.Logf(TEXT("Streaming levels: %d shared by reference, %d filtered per connection (%d actors)"),
+		AlwaysRelevantStreamingLevelActors.Num() - NumFilteredLevels, NumFilteredLevels, NumFilteredLevelActors);
+
+	int64 TotalEntries = 0;
+	for (auto& ConnectionList : { Connections, PendingConnections })
+	{
+		for (UNetReplicationGraphConnection* Connection : ConnectionList)
+		{
+			const FPerConnectionActorInfoMap& ActorInfoMap = Connection->ActorInfoMap;
+
+			int32 NumStreamingLevelEntries = 0;
+			for (const TPair<FName, FDAStreamingLevelActorList>& LevelActors : AlwaysRelevantStreamingLevelActors)
+			{
+				for (FActorRepListType Actor : LevelActors.Value.ActorList.Actors)
 				{
-					UDAReplicationGraphNode_AlwaysRelevant_ForConnection* Node = Cast<UDAReplicationGraphNode_AlwaysRelevant_ForConnection>(ConnectionNode);
-					if (Node != NULL)
+					if (ActorInfoMap.Find(Actor) != nullptr)
 					{
-						return Node;
+						++NumStreamingLevelEntries;
 					}
 				}
 			}
+
+			Ar.Logf(TEXT("%s: %d actor infos (%.1f KB), %d/%d streaming-level actors materialized"),
+				*GetNameSafe(Connection->NetConnection), ActorInfoMap.Num(), (ActorInfoMap.Num() * BytesPerEntry) / 1024.f,
+				NumStreamingLevelEntries, NumStreamingLevelActors);
+
+			TotalEntries += ActorInfoMap.Num();
 		}
 	}
 
-	return nullptr;
+	Ar.Logf(TEXT("Total: %lld actor infos (%.2f MB)"), TotalEntries, (TotalEntries * BytesPerEntry) / (1024.f * 1024.f));
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice CmdPrintConnectionActorInfoMemory(
+	TEXT("MyRepGraph.PrintConnectionActorInfoMemory"),
+	TEXT("Logs per-connection actor info memory usage of the replication graph."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		for (TObjectIterator<UMyReplicationGraph> It; It; ++It)
+		{
+			if (It->GetWorld() == World)
+			{
+				It->LogConnectionActorInfoMemory(Ar);
+			}
+		}
+	}));
+
+void UMyReplicationGraph::LogActorListPool(FOutputDevice& Ar)
+{
+	Ar.Logf(TEXT("Actor list pool: %d free lists in %d size classes, block size %d, %d heap allocations (%d since last report)"),
+		ActorListPool.GetNumFreeLists(), ActorListPool.FreeLists.Num(), ActorListPool.BlockSize, ActorListPool.NumHeapAllocations,
+		ActorListPool.NumHeapAllocations - NumActorListPoolAllocationsAtLastLog);
+
+	if (bCountHeapAllocations)
+	{
+		Ar.Logf(TEXT("Heap allocations: gather nodes %lld (%lld since last report), replication frames %lld (%lld since last report)"),
+			NumGatherHeapAllocations, NumGatherHeapAllocations - NumGatherHeapAllocationsAtLastLog,
+			NumReplicationHeapAllocations, NumReplicationHeapAllocations - NumReplicationHeapAllocationsAtLastLog);
+	}
+	else
+	{
+		Ar.Logf(TEXT("Heap allocations are not counted, start the server with -RepGraphCountAllocations or -RepGraphSoak."));
+	}
+
+	NumActorListPoolAllocationsAtLastLog = ActorListPool.NumHeapAllocations;
+	NumGatherHeapAllocationsAtLastLog = NumGatherHeapAllocations;
+	NumReplicationHeapAllocationsAtLastLog = NumReplicationHeapAllocations;
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice CmdPrintActorListPool(
+	TEXT("MyRepGraph.PrintActorListPool"),
+	TEXT("Logs the actor list pool and the heap allocations of the gather nodes and of replication since the last call."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		for (TObjectIterator<UMyReplicationGraph> It; It; ++It)
+		{
+			if (It->GetWorld() == World)
+			{
+				It->LogActorListPool(Ar);
+			}
+		}
+	}));
+
+void UMyReplicationGraph::BeginReplayActorLists()
+{
+	if (bKeepReplayActorLists)
+	{
+		return;
+	}
+
+	bKeepReplayActorLists = true;
+	for (AActor* Actor : ActiveNetworkActors)
+	{
+		if (IsValid(Actor))
+		{
+			const FNewReplicatedActorInfo ActorInfo(Actor);
+			AddReplayActor(ActorInfo, GetMappingPolicy(ActorInfo.Class));
+		}
+	}
+}
+
+void UMyReplicationGraph::AddReplayActor(const FNewReplicatedActorInfo& ActorInfo, EClassRepPolicy MappingPolicy)
+{
+	if (MappingPolicy == EClassRepPolicy::NotRouted)
+	{
+		return;
+	}
+
+	if (MappingPolicy == EClassRepPolicy::RelevantAllConnections && ActorInfo.StreamingLevelName == NAME_None)
+	{
+		ActorListPool.Add(ReplayAlwaysRelevantActors, ActorInfo.Actor);
+	}
+	else
+	{
+		ActorListPool.Add(ReplayActorLists.FindOrAdd(MappingPolicy), ActorInfo.Actor);
+	}
+}
+
+uint32 UMyReplicationGraph::GetReplayGatherPeriod() const
+{
+	return FMath::Max(1u, (uint32)ReplayGatherPeriod);
+}
+
+uint32 UMyReplicationGraph::GetReplayReplicationPeriod(EClassRepPolicy Policy) const
+{
+	float Period = 1.f;
+	switch (Policy)
+	{
+	case EClassRepPolicy::RelevantAllConnections:
+		Period = ReplayReplicationPeriodForRelevantAll;
+		break;
+	case EClassRepPolicy::RelevantGroup:
+		Period = ReplayReplicationPeriodForGroup;
+		break;
+	case EClassRepPolicy::Spatialize_Static:
+		Period = ReplayReplicationPeriodForStatic;
+		break;
+	case EClassRepPolicy::Spatialize_Dynamic:
+		Period = ReplayReplicationPeriodForDynamic;
+		break;
+	case EClassRepPolicy::Spatialize_Dormancy:
+		Period = ReplayReplicationPeriodForDormancy;
+		break;
+	default:
+		break;
+	}
+
+	return FMath::Max(GetReplayGatherPeriod(), (uint32)Period);
 }
 
 EClassRepPolicy UMyReplicationGraph::GetMappingPolicy(UClass* InClass)
@@ -308,20 +744,35 @@ EClassRepPolicy UMyReplicationGraph::GetMappingPolicy(UClass* InClass)
 }
 
 // Gathers AlwaysRelevant actor lists for streaming levels currently visible to this client.
-// Skips dormant actors and removes streaming levels with no active actors from the client's view.
 // Called every replication tick to update which streaming-level actors should be replicated to this connection.
+// Levels without actors that can go dormant are gathered by reference, shared by every connection that sees them.
+// The graph creates a full FConnectionReplicationActorInfo for every actor it is handed, so in the other levels
+// only the actors that still need replicating are gathered, into a per-connection list:
+// - actors already dormant on this connection are skipped,
+// - level-placed DORM_Initial actors that were never replicated here are skipped, the client already has
+//   them from the level package, so they get no per-connection info until FlushNetDormancy() wakes them.
 void UDAReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
 {
-	Super::GatherActorListsForConnection(Params);
 	UMyReplicationGraph* RepGraph = CastChecked<UMyReplicationGraph>(GetOuter());
+	FDAScopedHeapAllocationCounter AllocationCounter(RepGraph->NumGatherHeapAllocations);
+
+	Super::GatherActorListsForConnection(Params);
+
+	if (bReplayConnection)
+	{
+		GatherReplayActorLists(Params, *RepGraph);
+		return;
+	}
 
 	FPerConnectionActorInfoMap& ConnectionActorInfoMap = Params.ConnectionManager.ActorInfoMap;
-	TMap<FName, FActorRepListRefView>& AlwaysRelevantStreamingLevelActors = RepGraph->AlwaysRelevantStreamingLevelActors;
+	TMap<FName, FDAStreamingLevelActorList>& AlwaysRelevantStreamingLevelActors = RepGraph->AlwaysRelevantStreamingLevelActors;
+
+	StreamingLevelActorList.Reset();
 
 	for (int32 Idx = AlwaysRelevantStreamingLevels.Num() - 1; Idx >= 0; --Idx)
 	{
 		FName StreamingLevel = AlwaysRelevantStreamingLevels[Idx];
-		FActorRepListRefView* ListPtr = AlwaysRelevantStreamingLevelActors.Find(StreamingLevel);
+		FDAStreamingLevelActorList* ListPtr = AlwaysRelevantStreamingLevelActors.Find(StreamingLevel);
 
 		if (ListPtr == nullptr)
 		{
@@ -329,32 +780,87 @@ void UDAReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForCo
 			continue;
 		}
 
-		FActorRepListRefView& RepList = *ListPtr;
-		if (RepList.Num() > 0)
+		if (!ListPtr->bHasDormancyActors)
 		{
-			bool bAllDormant = true;
-			for (FActorRepListType Actor : RepList)
+			if (ListPtr->ActorList.Actors.Num() > 0)
 			{
-				FConnectionReplicationActorInfo& ConnectionActorInfo = ConnectionActorInfoMap.FindOrAdd(Actor);
-				if (ConnectionActorInfo.bDormantOnConnection == false)
-				{
-					bAllDormant = false;
-					break;
-				}
+				Params.OutGatheredReplicationLists.AddReplicationActorList(ListPtr->ActorList.Actors);
 			}
+			continue;
+		}
 
-			if (bAllDormant == true)
+		// Levels whose actors are all dormant stay in the list, so a dormancy flush is picked up on the next frame.
+		for (FActorRepListType Actor : ListPtr->ActorList.Actors)
+		{
+			const FConnectionReplicationActorInfo* ConnectionActorInfo = ConnectionActorInfoMap.Find(Actor);
+			if (ConnectionActorInfo == nullptr)
 			{
-				AlwaysRelevantStreamingLevels.RemoveAtSwap(Idx, 1, false);
+				if (Actor->NetDormancy == DORM_Initial && Actor->IsNetStartupActor())
+				{
+					continue;
+				}
 			}
-			else
+			else if (ConnectionActorInfo->bDormantOnConnection)
 			{
-				Params.OutGatheredReplicationLists.AddReplicationActorList(RepList);
+				continue;
 			}
+
+			StreamingLevelActorList.Add(Actor);
+		}
+	}
+
+	if (StreamingLevelActorList.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(StreamingLevelActorList);
+	}
+}
+
+// The replay connection records the whole map, so it takes every routed actor at once,
+// but only on every ReplayGatherPeriod-th frame. Each actor gets the replay period of its policy and no cull distance
+// on this connection when its entry is created, which leaves the settings used for live connections untouched.
+// Non-streaming RelevantAllConnections actors are gathered by the global AlwaysRelevant node on every frame,
+// so only their entries are given the replay period here.
+void UDAReplicationGraphNode_AlwaysRelevant_ForConnection::GatherReplayActorLists(const FConnectionGatherActorListParameters& Params, UMyReplicationGraph& RepGraph)
+{
+	if (Params.ReplicationFrameNum % RepGraph.GetReplayGatherPeriod() != 0)
+	{
+		return;
+	}
+
+	FPerConnectionActorInfoMap& ConnectionActorInfoMap = Params.ConnectionManager.ActorInfoMap;
+
+	const uint32 AlwaysRelevantPeriodFrame = RepGraph.GetReplayReplicationPeriod(EClassRepPolicy::RelevantAllConnections);
+	for (FActorRepListType Actor : RepGraph.ReplayAlwaysRelevantActors.Actors)
+	{
+		FConnectionReplicationActorInfo& ConnectionActorInfo = ConnectionActorInfoMap.FindOrAdd(Actor);
+		if (ConnectionActorInfo.ReplicationPeriodFrame != AlwaysRelevantPeriodFrame)
+		{
+			ConnectionActorInfo.ReplicationPeriodFrame = AlwaysRelevantPeriodFrame;
+			ConnectionActorInfo.SetCullDistanceSquared(0.f);
 		}
 	}
 
+	for (TPair<EClassRepPolicy, FDAPooledActorList>& PolicyActors : RepGraph.ReplayActorLists)
+	{
+		FActorRepListRefView& RepList = PolicyActors.Value.Actors;
+		if (RepList.Num() == 0)
+		{
+			continue;
+		}
+
+		const uint32 ReplicationPeriodFrame = RepGraph.GetReplayReplicationPeriod(PolicyActors.Key);
+		for (FActorRepListType Actor : RepList)
+		{
+			if (ConnectionActorInfoMap.Find(Actor) == nullptr)
+			{
+				FConnectionReplicationActorInfo& ConnectionActorInfo = ConnectionActorInfoMap.FindOrAdd(Actor);
+				ConnectionActorInfo.ReplicationPeriodFrame = ReplicationPeriodFrame;
+				ConnectionActorInfo.SetCullDistanceSquared(0.f);
+			}
+		}
 
+		Params.OutGatheredReplicationLists.AddReplicationActorList(RepList);
+	}
 }
 
 void UDAReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityAdd(FName LevelName, UWorld* LevelWorld)
@@ -370,4 +876,498 @@ void UDAReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibili
 void UDAReplicationGraphNode_AlwaysRelevant_ForConnection::ResetGameWorldState()
 {
 	AlwaysRelevantStreamingLevels.Empty();
+}
+
+void UDAReplicationGraphNode_AlwaysRelevant_ForConnection::AddReplicationGroup(int32 GroupId)
+{
+	ReplicationGroups.AddUnique(GroupId);
+}
+
+void UDAReplicationGraphNode_AlwaysRelevant_ForConnection::RemoveReplicationGroup(int32 GroupId)
+{
+	ReplicationGroups.RemoveSwap(GroupId);
+}
+
+void UDAReplicationGraphNode_AlwaysRelevant_ForConnection::BeginJoinWarmup()
+{
+	JoinWarmup.bActive = true;
+	JoinWarmup.NumFrames = 0;
+	JoinWarmup.StartTime = FPlatformTime::Seconds();
+	JoinWarmup.AdmittedActors.Reset();
+	JoinWarmup.ActorList.Reset();
+}
+
+/*============================================================================*/
+
+// Uses the regular grid gather unless the connection is warming up.
+// A viewer that moves farther than WarmupTeleportDistance in one frame restarts the warmup.
+void UDAReplicationGraphNode_GridSpatialization2D::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	UMyReplicationGraph* RepGraph = CastChecked<UMyReplicationGraph>(GetOuter());
+	UDAReplicationGraphNode_AlwaysRelevant_ForConnection* ConnectionNode = RepGraph->GetAlwaysRelevantNode(Params.ConnectionManager);
+
+	// Replay connections gather the whole map from their AlwaysRelevant node instead.
+	if (ConnectionNode != nullptr && ConnectionNode->bReplayConnection)
+	{
+		return;
+	}
+
+	if (ConnectionNode == nullptr || WarmupChannelBudgetPerFrame <= 0)
+	{
+		FDAScopedHeapAllocationCounter AllocationCounter(RepGraph->NumGatherHeapAllocations);
+		Super::GatherActorListsForConnection(Params);
+		return;
+	}
+
+	FDAJoinWarmupState& Warmup = ConnectionNode->JoinWarmup;
+	if (Params.Viewers.Num() > 0)
+	{
+		const FVector ViewLocation = Params.Viewers[0].ViewLocation;
+		if (Warmup.bHasViewLocation && WarmupTeleportDistance > 0.f && FVector::DistSquared(ViewLocation, Warmup.LastViewLocation) > FMath::Square(WarmupTeleportDistance))
+		{
+			ConnectionNode->BeginJoinWarmup();
+		}
+
+		Warmup.bHasViewLocation = true;
+		Warmup.LastViewLocation = ViewLocation;
+	}
+
+	// Warmups build their admitted set and lists while they run, they are not counted as steady-state gather allocations.
+	if (Warmup.bActive)
+	{
+		GatherWarmupActorLists(Params, *ConnectionNode);
+	}
+	else
+	{
+		FDAScopedHeapAllocationCounter AllocationCounter(RepGraph->NumGatherHeapAllocations);
+		Super::GatherActorListsForConnection(Params);
+	}
+}
+
+// Gathers the grid into a scratch list and lets actors through nearest first.
+// Actors that already have a channel (or are dormant on it) cost nothing, every other actor
+// uses one slot of WarmupChannelBudgetPerFrame. The warmup completes once nothing is left pending
+// and every admitted actor in cull range has an open channel or is dormant on the connection,
+// or times out after WarmupMaxFrames.
+void UDAReplicationGraphNode_GridSpatialization2D::GatherWarmupActorLists(const FConnectionGatherActorListParameters& Params, UDAReplicationGraphNode_AlwaysRelevant_ForConnection& ConnectionNode)
+{
+	FDAJoinWarmupState& Warmup = ConnectionNode.JoinWarmup;
+
+	WarmupCandidateLists.Reset();
+	FConnectionGatherActorListParameters CandidateParams(Params.Viewers, Params.ConnectionManager, Params.ClientVisibleLevelNamesRef, Params.ReplicationFrameNum, WarmupCandidateLists, Params.bIsSelectedForHeavyComputation);
+	Super::GatherActorListsForConnection(CandidateParams);
+
+	struct FWarmupCandidate
+	{
+		FActorRepListType Actor;
+		float DistanceSquared;
+	};
+
+	// Candidates live on the frame's mem stack, which is popped when this function returns.
+	FMemMark MemMark(FMemStack::Get());
+	TArray<FWarmupCandidate, TMemStackAllocator<>> Candidates;
+	for (const auto& CandidateList : WarmupCandidateLists.GetLists(EActorRepListTypeFlags::Default))
+	{
+		for (FActorRepListType Actor : CandidateList)
+		{
+			const FVector ActorLocation = Actor->GetActorLocation();
+			float DistanceSquared = TNumericLimits<float>::Max();
+			for (const FNetViewer& Viewer : Params.Viewers)
+			{
+				DistanceSquared = FMath::Min<float>(DistanceSquared, FVector::DistSquared(ActorLocation, Viewer.ViewLocation));
+			}
+
+			Candidates.Add({ Actor, DistanceSquared });
+		}
+	}
+
+	Candidates.Sort([](const FWarmupCandidate& A, const FWarmupCandidate& B) { return A.DistanceSquared < B.DistanceSquared; });
+
+	int32 Budget = WarmupChannelBudgetPerFrame;
+	int32 NumPending = 0;
+	int32 NumAwaitingChannel = 0;
+	Warmup.ActorList.Reset();
+
+	for (const FWarmupCandidate& Candidate : Candidates)
+	{
+		const FConnectionReplicationActorInfo* ConnectionActorInfo = Params.ConnectionManager.ActorInfoMap.Find(Candidate.Actor);
+		const bool bHasChannel = ConnectionActorInfo != nullptr && (ConnectionActorInfo->Channel != nullptr || ConnectionActorInfo->bDormantOnConnection);
+
+		if (!Warmup.AdmittedActors.Contains(Candidate.Actor))
+		{
+			if (!bHasChannel)
+			{
+				if (Budget <= 0)
+				{
+					++NumPending;
+					continue;
+				}
+				--Budget;
+			}
+
+			Warmup.AdmittedActors.Add(Candidate.Actor);
+		}
+
+		// Actors outside their cull distance never get a channel, so they do not hold up completion.
+		const bool bOutOfCullRange = ConnectionActorInfo != nullptr && ConnectionActorInfo->GetCullDistanceSquared() > 0.f && Candidate.DistanceSquared > ConnectionActorInfo->GetCullDistanceSquared();
+		if (!bHasChannel && !bOutOfCullRange)
+		{
+			++NumAwaitingChannel;
+		}
+
+		Warmup.ActorList.Add(Candidate.Actor);
+	}
+
+	if (Warmup.ActorList.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(Warmup.ActorList);
+	}
+
+	++Warmup.NumFrames;
+	const bool bCompleted = NumPending == 0 && NumAwaitingChannel == 0;
+	if (bCompleted || Warmup.NumFrames >= WarmupMaxFrames)
+	{
+		const double Seconds = FPlatformTime::Seconds() - Warmup.StartTime;
+		if (bCompleted)
+		{
+			++WarmupStats.NumCompleted;
+		}
+		else
+		{
+			++WarmupStats.NumTimedOut;
+		}
+		WarmupStats.LastFrames = Warmup.NumFrames;
+		WarmupStats.LastSeconds = Seconds;
+		WarmupStats.MaxSeconds = FMath::Max(WarmupStats.MaxSeconds, Seconds);
+		WarmupStats.TotalSeconds += Seconds;
+
+		CSV_CUSTOM_STAT_GLOBAL(RepGraphJoinWarmupFrames, Warmup.NumFrames, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT_GLOBAL(RepGraphJoinWarmupSeconds, (float)Seconds, ECsvCustomStatOp::Set);
+
+		UE_LOG(LogTemp, Log, TEXT("Join warmup for %s %s in %d frames (%.2f s): %d actors admitted, %d still pending, %d without channel"),
+			*GetNameSafe(Params.ConnectionManager.NetConnection), bCompleted ? TEXT("completed") : TEXT("timed out"), Warmup.NumFrames, Seconds,
+			Warmup.AdmittedActors.Num(), NumPending, NumAwaitingChannel);
+
+		// Free the set, keeping it would hold memory for every actor this connection ever admitted.
+		Warmup.bActive = false;
+		Warmup.AdmittedActors.Empty();
+	}
+}
+
+/*============================================================================*/
+
+void UDAReplicationGraphNode_GroupRelevancy::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	AGroupRelevantActor* GroupActor = Cast<AGroupRelevantActor>(ActorInfo.Actor);
+	if (GroupActor != nullptr && GroupActor->GetReplicationGroup() != INDEX_NONE)
+	{
+		UMyReplicationGraph* RepGraph = CastChecked<UMyReplicationGraph>(GetOuter());
+		RepGraph->ActorListPool.Add(GroupActorLists.FindOrAdd(GroupActor->GetReplicationGroup()), ActorInfo.Actor);
+	}
+}
+
+// The actor's group may already have changed by the time it is removed, so every group list is checked.
+bool UDAReplicationGraphNode_GroupRelevancy::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	UMyReplicationGraph* RepGraph = CastChecked<UMyReplicationGraph>(GetOuter());
+	for (TPair<int32, FDAPooledActorList>& GroupActors : GroupActorLists)
+	{
+		if (RepGraph->ActorListPool.RemoveFast(GroupActors.Value, ActorInfo.Actor))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UDAReplicationGraphNode_GroupRelevancy::NotifyResetAllNetworkActors()
+{
+	UMyReplicationGraph* RepGraph = CastChecked<UMyReplicationGraph>(GetOuter());
+	for (TPair<int32, FDAPooledActorList>& GroupActors : GroupActorLists)
+	{
+		RepGraph->ActorListPool.Release(GroupActors.Value);
+	}
+	GroupActorLists.Reset();
+}
+
+// Adds the group lists by reference, every connection of the same team shares the same list.
+void UDAReplicationGraphNode_GroupRelevancy::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	UMyReplicationGraph* RepGraph = CastChecked<UMyReplicationGraph>(GetOuter());
+	FDAScopedHeapAllocationCounter AllocationCounter(RepGraph->NumGatherHeapAllocations);
+	UDAReplicationGraphNode_AlwaysRelevant_ForConnection* ConnectionNode = RepGraph->GetAlwaysRelevantNode(Params.ConnectionManager);
+	if (ConnectionNode == nullptr)
+	{
+		return;
+	}
+
+	for (int32 GroupId : ConnectionNode->GetReplicationGroups())
+	{
+		const FDAPooledActorList* GroupActors = GroupActorLists.Find(GroupId);
+		if (GroupActors != nullptr && GroupActors->Actors.Num() > 0)
+		{
+			Params.OutGatheredReplicationLists.AddReplicationActorList(GroupActors->Actors);
+		}
+	}
+}
+
+void UDAReplicationGraphNode_GroupRelevancy::MoveGroupActor(AActor* Actor, int32 OldGroupId, int32 NewGroupId)
+{
+	UMyReplicationGraph* RepGraph = CastChecked<UMyReplicationGraph>(GetOuter());
+	if (FDAPooledActorList* OldGroupActors = GroupActorLists.Find(OldGroupId))
+	{
+		RepGraph->ActorListPool.RemoveFast(*OldGroupActors, Actor);
+	}
+
+	if (NewGroupId != INDEX_NONE)
+	{
+		RepGraph->ActorListPool.Add(GroupActorLists.FindOrAdd(NewGroupId), Actor);
+	}
+}
+
+/*============================================================================*/
+
+void FDAActorListPool::Add(FDAPooledActorList& List, FActorRepListType Actor)
+{
+	if (List.Actors.Num() >= List.Capacity)
+	{
+		Grow(List);
+	}
+
+	List.Actors.Add(Actor);
+}
+
+bool FDAActorListPool::RemoveFast(FDAPooledActorList& List, FActorRepListType Actor)
+{
+	const bool bRemoved = List.Actors.RemoveFast(Actor);
+	if (List.Actors.Num() == 0 && List.Capacity > 0)
+	{
+		Release(List);
+	}
+
+	return bRemoved;
+}
+
+void FDAActorListPool::Release(FDAPooledActorList& List)
+{
+	if (List.Capacity == 0)
+	{
+		return;
+	}
+
+	const int32 SizeClass = GetSizeClass(List.Capacity);
+	if (FreeLists.Num() <= SizeClass)
+	{
+		if (FreeLists.Max() <= SizeClass)
+		{
+			++NumHeapAllocations;
+		}
+		FreeLists.SetNum(SizeClass + 1);
+	}
+
+	TArray<FDAPooledActorList>& ClassFreeLists = FreeLists[SizeClass];
+	if (ClassFreeLists.Num() == ClassFreeLists.Max())
+	{
+		ClassFreeLists.Reserve(ClassFreeLists.Max() + 16);
+		++NumHeapAllocations;
+	}
+
+	List.Actors.Reset();
+	ClassFreeLists.Add(MoveTemp(List));
+	List = FDAPooledActorList();
+}
+
+int32 FDAActorListPool::GetNumFreeLists() const
+{
+	int32 NumFreeLists = 0;
+	for (const TArray<FDAPooledActorList>& ClassFreeLists : FreeLists)
+	{
+		NumFreeLists += ClassFreeLists.Num();
+	}
+
+	return NumFreeLists;
+}
+
+int32 FDAActorListPool::GetSizeClass(int32 Capacity) const
+{
+	return (int32)FMath::FloorLog2((uint32)(Capacity / BlockSize));
+}
+
+// Growing doubles the capacity, so a list of N actors is copied about log2(N / BlockSize) times in total.
+void FDAActorListPool::Grow(FDAPooledActorList& List)
+{
+	const int32 SizeClass = List.Capacity == 0 ? 0 : GetSizeClass(List.Capacity) + 1;
+
+	FDAPooledActorList NewList;
+	if (FreeLists.IsValidIndex(SizeClass) && FreeLists[SizeClass].Num() > 0)
+	{
+		NewList = FreeLists[SizeClass].Pop(false);
+	}
+	else
+	{
+		NewList.Capacity = BlockSize << SizeClass;
+		NewList.Actors.Reserve(NewList.Capacity);
+		++NumHeapAllocations;
+	}
+
+	for (FActorRepListType Actor : List.Actors)
+	{
+		NewList.Actors.Add(Actor);
+	}
+
+	Release(List);
+	List = MoveTemp(NewList);
+}
+
+/*============================================================================*/
+
+// Innermost counter of the allocation scopes open on this thread.
+static thread_local int64* GDAHeapAllocationCounter = nullptr;
+
+// Forwards everything to the allocator it wraps and counts Malloc/Realloc calls made inside a counter scope.
+class FDACountingMallocProxy final : public FMalloc
+{
+public:
+
+	explicit FDACountingMallocProxy(FMalloc* InUsedMalloc)
+		: UsedMalloc(InUsedMalloc)
+	{
+	}
+
+	virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+	{
+		CountAllocation();
+		return UsedMalloc->Malloc(Size, Alignment);
+	}
+
+	virtual void* TryMalloc(SIZE_T Size, uint32 Alignment) override
+	{
+		CountAllocation();
+		return UsedMalloc->TryMalloc(Size, Alignment);
+	}
+
+	// A realloc to size 0 is a free and is not counted.
+	virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override
+	{
+		if (Size > 0)
+		{
+			CountAllocation();
+		}
+		return UsedMalloc->Realloc(Original, Size, Alignment);
+	}
+
+	virtual void* TryRealloc(void* Original, SIZE_T Size, uint32 Alignment) override
+	{
+		if (Size > 0)
+		{
+			CountAllocation();
+		}
+		return UsedMalloc->TryRealloc(Original, Size, Alignment);
+	}
+
+	virtual void Free(void* Original) override { UsedMalloc->Free(Original); }
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return UsedMalloc->QuantizeSize(Count, Alignment); }
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return UsedMalloc->GetAllocationSize(Original, SizeOut); }
+	virtual void Trim(bool bTrimThreadCaches) override { UsedMalloc->Trim(bTrimThreadCaches); }
+	virtual void SetupTLSCachesOnCurrentThread() override { UsedMalloc->SetupTLSCachesOnCurrentThread(); }
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override { UsedMalloc->ClearAndDisableTLSCachesOnCurrentThread(); }
+	virtual void InitializeStatsMetadata() override { UsedMalloc->InitializeStatsMetadata(); }
+	virtual void UpdateStats() override { UsedMalloc->UpdateStats(); }
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { UsedMalloc->GetAllocatorStats(OutStats); }
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override { UsedMalloc->DumpAllocatorStats(Ar); }
+	virtual bool IsInternallyThreadSafe() const override { return UsedMalloc->IsInternallyThreadSafe(); }
+	virtual bool ValidateHeap() override { return UsedMalloc->ValidateHeap(); }
+	virtual const TCHAR* GetDescriptiveName() override { return UsedMalloc->GetDescriptiveName(); }
+	virtual void OnMallocInitialized() override { UsedMalloc->OnMallocInitialized(); }
+	virtual void OnPreFork() override { UsedMalloc->OnPreFork(); }
+	virtual void OnPostFork() override { UsedMalloc->OnPostFork(); }
+
+private:
+
+	static void CountAllocation()
+	{
+		if (int64* Counter = GDAHeapAllocationCounter)
+		{
+			++*Counter;
+		}
+	}
+
+	FMalloc* UsedMalloc;
+};
+
+FDAScopedHeapAllocationCounter::FDAScopedHeapAllocationCounter(int64& InCounter)
+	: Counter(InCounter)
+	, StartCount(InCounter)
+	, OuterCounter(GDAHeapAllocationCounter)
+{
+	GDAHeapAllocationCounter = &Counter;
+}
+
+FDAScopedHeapAllocationCounter::~FDAScopedHeapAllocationCounter()
+{
+	GDAHeapAllocationCounter = OuterCounter;
+	if (OuterCounter != nullptr)
+	{
+		*OuterCounter += Counter - StartCount;
+	}
+}
+
+// The proxy is installed once and never removed. Threads that read GMalloc before the swap keep
+// calling the wrapped allocator directly, which is safe because the proxy frees through it as well.
+bool FDAScopedHeapAllocationCounter::InstallHeapAllocationCounting()
+{
+#if PLATFORM_USES_FIXED_GMalloc_CLASS
+	return false;
+#else
+	static FDACountingMallocProxy* CountingMalloc = nullptr;
+	if (CountingMalloc == nullptr && GMalloc != nullptr)
+	{
+		CountingMalloc = new FDACountingMallocProxy(GMalloc);
+		GMalloc = CountingMalloc;
+	}
+
+	return CountingMalloc != nullptr;
+#endif
+}
+
+/*============================================================================*/
+
+void FDASoakTelemetry::Start(double Now)
+{
+	ReplicationTimeBuckets.SetNumZeroed(NumBuckets);
+	bStarted = true;
+	StartTime = Now;
+	LastSampleTime = Now;
+}
+
+void FDASoakTelemetry::ResetHistogram()
+{
+	FMemory::Memzero(ReplicationTimeBuckets.GetData(), ReplicationTimeBuckets.Num() * sizeof(int32));
+	NumFrames = 0;
+	MaxReplicationMs = 0.0;
+}
+
+void FDASoakTelemetry::RecordFrame(double ReplicationMs)
+{
+	const int32 Bucket = FMath::Clamp((int32)(ReplicationMs / BucketMs), 0, NumBuckets - 1);
+	++ReplicationTimeBuckets[Bucket];
+	++NumFrames;
+	MaxReplicationMs = FMath::Max(MaxReplicationMs, ReplicationMs);
+}
+
+double FDASoakTelemetry::GetPercentileMs(double Percentile) const
+{
+	const int64 Target = (int64)FMath::CeilToDouble(NumFrames * Percentile);
+	int64 Count = 0;
+	for (int32 Bucket = 0; Bucket < ReplicationTimeBuckets.Num(); ++Bucket)
+	{
+		Count += ReplicationTimeBuckets[Bucket];
+		if (Count >= Target)
+		{
+			return (Bucket + 1) * BucketMs;
+		}
+	}
+
+	return MaxReplicationMs;
 }
\ No newline at end of file
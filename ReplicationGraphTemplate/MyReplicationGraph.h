@@ -27,9 +27,19 @@ enum class EClassRepPolicy : uint8
 	// These actors are added to a special AlwaysRelevant list.
 	RelevantAllConnections,
 
-	// The actor is spatialized and assumed to have frequent updates (e.g., every frame).
+	// The actor is relevant only to connections that belong to its replication group (e.g. a team or squad).
+	// The group relevancy node keeps one actor list per group, and each connection pulls the lists
+	// of its own groups instead of filtering every actor by owner.
+	// Use for team markers, objectives, squad pings.
+	RelevantGroup,
+
+	// The actor is spatialized but does not move.
 	// It will be placed in the spatial grid, in a node for *static* actors.
-	// Use this for actors that update frequently but don't move (e.g., ticking effects).
+	// Use this for level actors whose state rarely changes (e.g., props, signs, static meshes).
+	// Actors that want dormancy (like AStaticRepActor) are moved to the cell's dormancy node
+	// and stop being checked for a connection once they are dormant on it.
+	// Dormant actors are not woken automatically: after changing replicated state, call
+	// AStaticRepActor::MarkReplicatedStateDirty() or FlushNetDormancy().
 	Spatialize_Static,
 
 	// The actor is spatialized and updates are needed every frame.
@@ -46,8 +56,119 @@ enum class EClassRepPolicy : uint8
 class UReplicationGraphNode_ActorList;
 class UReplicationGraphNode_GridSpatialization2D;
 class UReplicationGraphNode_AlwaysRelevant_ForConnection;
+class UDAReplicationGraphNode_AlwaysRelevant_ForConnection;
+class UDAReplicationGraphNode_GroupRelevancy;
+class UDAReplicationGraphNode_GridSpatialization2D;
 class AGameplayDebuggerCategoryReplicator;
 
+// Actor list whose storage is handed out by FDAActorListPool.
+// Capacity is always BlockSize << N actors, so the storage can be recycled between lists of the same size class.
+struct FDAPooledActorList
+{
+	FActorRepListRefView Actors;
+	int32 Capacity = 0;
+};
+
+// Block pool for the actor lists the graph keeps per streaming level, replication group and replay policy.
+// Storage comes in size classes of BlockSize, 2 * BlockSize, 4 * BlockSize... actors. A full list moves its actors
+// into storage of the next class and hands its old storage back, and an emptied list returns its storage,
+// so actors streaming in and out only touch the heap while the pool has no storage of the class they need.
+// NumHeapAllocations counts every list or free list reservation, which are the only heap allocations the pool makes.
+struct FDAActorListPool
+{
+	// Adds the actor, moving the list to storage of the next size class if it is full.
+	void Add(FDAPooledActorList& List, FActorRepListType Actor);
+
+	// Removes the actor and returns the storage to the pool if the list became empty.
+	bool RemoveFast(FDAPooledActorList& List, FActorRepListType Actor);
+
+	// Returns the storage of the list to the pool.
+	void Release(FDAPooledActorList& List);
+
+	// Number of free storage blocks over all size classes.
+	int32 GetNumFreeLists() const;
+
+	// Number of actors the smallest size class holds.
+	int32 BlockSize = 64;
+
+	// Number of times the pool reserved list or free list storage. Stays constant once the pool is warm.
+	int32 NumHeapAllocations = 0;
+
+	// Empty storage ready to be reused, indexed by size class.
+	TArray<TArray<FDAPooledActorList>> FreeLists;
+
+private:
+
+	int32 GetSizeClass(int32 Capacity) const;
+
+	// Moves the actors of a full list into storage of the next size class.
+	void Grow(FDAPooledActorList& List);
+};
+
+// Counts the heap allocations made on the calling thread while it is in scope, into the given counter.
+// Allocations of nested scopes are added to the outer counters as well.
+// Only counts once InstallHeapAllocationCounting() has routed GMalloc through the counting proxy.
+struct FDAScopedHeapAllocationCounter
+{
+	explicit FDAScopedHeapAllocationCounter(int64& InCounter);
+	~FDAScopedHeapAllocationCounter();
+
+	// Wraps GMalloc in a proxy that counts Malloc/Realloc calls of threads inside a scope.
+	// Returns false on platforms that call their allocator directly instead of through GMalloc.
+	static bool InstallHeapAllocationCounting();
+
+private:
+
+	int64& Counter;
+	int64 StartCount;
+	int64* OuterCounter;
+};
+
+// Always relevant actors of one streaming level.
+struct FDAStreamingLevelActorList
+{
+	FDAPooledActorList ActorList;
+
+	// Set once an actor that can go dormant (NetDormancy above DORM_Awake) is in the level, cleared when the level empties.
+	// Connections gather levels without such actors by reference and only filter the others per connection.
+	bool bHasDormancyActors = false;
+};
+
+// Replication telemetry of a soak run.
+// Replication time goes into a fixed histogram every frame, so hours of samples need no allocations.
+struct FDASoakTelemetry
+{
+	// Histogram of replication time in 0.1 ms buckets, the last bucket collects everything slower.
+	static constexpr int32 NumBuckets = 1000;
+	static constexpr double BucketMs = 0.1;
+
+	void Start(double Now);
+	void RecordFrame(double ReplicationMs);
+
+	// Clears the histogram, so join and streaming spikes of the warmup period do not count toward the p99.
+	void ResetHistogram();
+
+	// Returns the upper edge of the bucket containing the given percentile (0-1).
+	double GetPercentileMs(double Percentile) const;
+
+	TArray<int32> ReplicationTimeBuckets;
+	int64 NumFrames = 0;
+	double MaxReplicationMs = 0.0;
+
+	bool bStarted = false;
+	double StartTime = 0.0;
+	double LastSampleTime = 0.0;
+
+	// Memory, pool and heap allocation counts once the warmup period is over, compared against at the end of the run.
+	bool bHasBaseline = false;
+	uint64 BaselineUsedPhysical = 0;
+	int32 BaselineActorListPoolAllocations = 0;
+	int64 BaselineGatherHeapAllocations = 0;
+	int64 BaselineReplicationHeapAllocations = 0;
+
+	bool bFinished = false;
+};
+
 /**
  * Custom replication graph for handling spatialized and always relevant actors.
  */
@@ -74,6 +195,9 @@ public:
 	// Called once on server start.
 	virtual void InitGlobalGraphNodes() override;
 
+	// Replicates actors to all connections. Wrapped to time the replication frame for soak telemetry.
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+
 	// Determines which replication node(s) an actor should be routed to.
 	// Called when an actor is added to the replication system.
 	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
@@ -82,10 +206,37 @@ public:
 	// Called when an actor is destroyed or no longer relevant.
 	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
 
+	// Switches the streaming level of an always relevant actor to per-connection filtering once the actor can go dormant.
+	virtual void NotifyActorDormancyChange(AActor* Actor, ENetDormancy OldDormancyState) override;
+
 	// Helper function to initialize FClassReplicationInfo values for a given actor class.
 	// You can configure cull distances, update frequency, and spatialization here.
 	void InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* InClass, bool bSpatilize, float ServerMaxTickRate);
 
+	// Logs how many per-connection actor infos each connection holds and roughly how much memory they use.
+	// Streaming-level actors get an entry on a connection once they are gathered for it; level-placed
+	// DORM_Initial actors that were never woken are not gathered and stay without one.
+	// Also logs how many streaming levels are filtered per connection instead of shared by reference.
+	// Bound to the console command MyRepGraph.PrintConnectionActorInfoMemory.
+	void LogConnectionActorInfoMemory(FOutputDevice& Ar) const;
+
+	// Logs the actor list pool state and the heap allocations made since the previous call,
+	// by the pool, by the graph's gather nodes and by the whole replication frame.
+	// Bound to the console command MyRepGraph.PrintActorListPool.
+	void LogActorListPool(FOutputDevice& Ar);
+
+	// Adds or removes the client of this PlayerController to/from a replication group.
+	// A connection can belong to several groups at once, e.g. its team and its squad.
+	void AddConnectionToReplicationGroup(APlayerController* PlayerController, int32 GroupId);
+	void RemoveConnectionFromReplicationGroup(APlayerController* PlayerController, int32 GroupId);
+
+	// Moves a RelevantGroup actor from the list of its old group to the list of its new one.
+	// Called by AGroupRelevantActor when its replication group changes on the server.
+	void NotifyActorReplicationGroupChanged(AActor* Actor, int32 OldGroupId, int32 NewGroupId);
+
+	// Returns the custom AlwaysRelevant node of a connection, or nullptr if it has none.
+	UDAReplicationGraphNode_AlwaysRelevant_ForConnection* GetAlwaysRelevantNode(UNetReplicationGraphConnection& ConnectionManager) const;
+
 	// Array of classes that are spatialized (added to spatial grid for relevance checking).
 	// These classes are routed to the spatial replication nodes.
 	UPROPERTY()
@@ -105,17 +256,51 @@ public:
 	// Needed for spatialized actors to be grouped by world space efficiently.
 	// Declared as UPROPERTY to prevent garbage collection.
 	UPROPERTY()
-	UReplicationGraphNode_GridSpatialization2D* GridNode;
+	UDAReplicationGraphNode_GridSpatialization2D* GridNode;
 
 	// Node that holds actors which are always relevant to all clients.
 	// Prevents garbage collection and ensures proper replication behavior.
 	UPROPERTY()
 	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
 
+	// Node that keeps one actor list per replication group (team or squad).
+	// Connections pull the lists of the groups they belong to during the gather.
+	UPROPERTY()
+	UDAReplicationGraphNode_GroupRelevancy* GroupRelevancyNode;
+
 	// Stores per-level actor lists that are always relevant to all connections.
 	// Used for streaming levels to ensure key actors (e.g. doors, triggers) are replicated
 	// to clients when the corresponding level becomes visible.
-	TMap<FName, FActorRepListRefView> AlwaysRelevantStreamingLevelActors;
+	TMap<FName, FDAStreamingLevelActorList> AlwaysRelevantStreamingLevelActors;
+
+	// Pool the streaming-level and replication group lists take their storage from.
+	// Kept across world resets so a long running server keeps reusing the same blocks.
+	FDAActorListPool ActorListPool;
+
+	// True if heap allocations are counted, set with soak telemetry or -RepGraphCountAllocations.
+	bool bCountHeapAllocations = false;
+
+	// Heap allocations of the graph's gather nodes, outside of join warmups. 0 per frame in steady state.
+	int64 NumGatherHeapAllocations = 0;
+
+	// Heap allocations of the game thread during ServerReplicateActors, engine replication included.
+	int64 NumReplicationHeapAllocations = 0;
+
+	// Every routed actor by replication policy, gathered by replay recording connections instead of the grid.
+	// Non-streaming RelevantAllConnections actors are left out, the global AlwaysRelevant node gathers them.
+	// Only filled once a replay connection was added and bUseReplayConnectionProfile is set.
+	TMap<EClassRepPolicy, FDAPooledActorList> ReplayActorLists;
+
+	// Non-streaming RelevantAllConnections actors. Not gathered, only used to give their entries on
+	// replay connections the replay period instead of the live one.
+	FDAPooledActorList ReplayAlwaysRelevantActors;
+
+	// Number of frames between two gathers of a replay connection.
+	uint32 GetReplayGatherPeriod() const;
+
+	// Replication period in frames of a replay connection for actors of the given policy.
+	// Never shorter than the gather period, otherwise channels would time out between two gathers.
+	uint32 GetReplayReplicationPeriod(EClassRepPolicy Policy) const;
 
 protected:
 
@@ -197,6 +382,147 @@ protected:
 	UPROPERTY(config)
 	float ActorReplicationPeriodForDormancy;
 
+	/*============================================================================*/
+	// Join warmup: when a client joins, or its view jumps far away (e.g. respawn), spatialized actors
+	// become relevant over several frames, nearest first, instead of all in the same frame.
+	// Always relevant and streaming-level actors are not paced.
+
+	// Maximum number of new actor channels opened per frame for a warming up connection.
+	// 0 disables the join warmup.
+	UPROPERTY(config)
+	int32 JoinWarmupChannelBudgetPerFrame;
+
+	// Number of frames after which the warmup ends even if actors are still pending.
+	UPROPERTY(config)
+	int32 JoinWarmupMaxFrames;
+
+	// Viewer movement within a single frame (in UU) that restarts the warmup. 0 = only on join.
+	UPROPERTY(config)
+	float JoinWarmupTeleportDistance;
+
+	/*============================================================================*/
+	// Number of actors per storage block of the pooled streaming-level and group lists.
+	// 0 keeps the default of 64.
+	UPROPERTY(config)
+	int32 ActorListPoolBlockSize;
+
+	/*============================================================================*/
+	// Replay recording profile: the demo connection of server-side replay recording skips the grid
+	// and gathers every routed actor of the map, but only every ReplayGatherPeriod frames and with
+	// its own replication periods, so recording costs much less than a live player.
+
+	UPROPERTY(config)
+	bool bUseReplayConnectionProfile;
+
+	// True once a replay connection was added to this graph, so it keeps ReplayActorLists up to date.
+	// Graphs that never record a replay skip the extra lists.
+	bool bKeepReplayActorLists = false;
+
+	// Fills the replay lists from every active network actor and starts keeping them up to date.
+	void BeginReplayActorLists();
+
+	// Adds a routed actor to the replay list of its policy.
+	void AddReplayActor(const FNewReplicatedActorInfo& ActorInfo, EClassRepPolicy MappingPolicy);
+
+	UPROPERTY(config)
+	float ReplayGatherPeriod;
+
+	// Number of server frames between replication updates on the replay connection, per policy.
+	UPROPERTY(config)
+	float ReplayReplicationPeriodForRelevantAll;
+
+	UPROPERTY(config)
+	float ReplayReplicationPeriodForGroup;
+
+	UPROPERTY(config)
+	float ReplayReplicationPeriodForDynamic;
+
+	UPROPERTY(config)
+	float ReplayReplicationPeriodForStatic;
+
+	UPROPERTY(config)
+	float ReplayReplicationPeriodForDormancy;
+
+	/*============================================================================*/
+	// Soak telemetry: records replication time, bytes per connection, channel counts and memory
+	// over a long run of the game net driver, then fails the run on memory growth or a slow p99.
+	// Enabled by bSoakTelemetry or the -RepGraphSoak command line switch.
+
+	UPROPERTY(config)
+	bool bSoakTelemetry;
+
+	// Length of the run in seconds. When it is over the verdict is logged and the server exits
+	// with code 0 (pass) or 1 (fail). 0 records until shutdown without a verdict.
+	// Overridden by -RepGraphSoakDuration=<Seconds> on the command line.
+	UPROPERTY(config)
+	float SoakDurationSeconds;
+
+	// Seconds between two logged samples.
+	UPROPERTY(config)
+	float SoakSampleInterval;
+
+	// Seconds after start before the memory baseline is taken, so joining and streaming settle first.
+	UPROPERTY(config)
+	float SoakWarmupSeconds;
+
+	// Memory growth above the baseline (in MB) that is reported as a leak.
+	UPROPERTY(config)
+	float SoakMaxMemoryGrowthMB;
+
+	// Budget for the 99th percentile of the server replication time (in ms).
+	UPROPERTY(config)
+	float SoakMaxP99ReplicationMs;
+
+	// Fails the run if the gather nodes or the actor list pool allocated heap memory after SoakWarmupSeconds.
+	UPROPERTY(config)
+	bool bSoakFailOnGatherAllocations;
+
+	bool bSoakActive = false;
+	FDASoakTelemetry SoakTelemetry;
+
+	// Records one replication frame and logs a sample or the verdict when due.
+	void TickSoakTelemetry(double ReplicationMs);
+
+	// Allocation counts at the last LogActorListPool() call.
+	int32 NumActorListPoolAllocationsAtLastLog = 0;
+	int64 NumGatherHeapAllocationsAtLastLog = 0;
+	int64 NumReplicationHeapAllocationsAtLastLog = 0;
+
+};
+
+// Join warmup completion metrics, summed over all connections of the graph.
+// A warmup completes when every admitted actor has an open channel (or is dormant on the connection).
+struct FDAJoinWarmupStats
+{
+	int32 NumCompleted = 0;
+	int32 NumTimedOut = 0;
+
+	// Frames and seconds of the most recent warmup, and the slowest and total seconds so far.
+	int32 LastFrames = 0;
+	double LastSeconds = 0.0;
+	double MaxSeconds = 0.0;
+	double TotalSeconds = 0.0;
+};
+
+// Per-connection state of the join warmup.
+// Updated by UDAReplicationGraphNode_GridSpatialization2D while the warmup is active.
+struct FDAJoinWarmupState
+{
+	bool bActive = false;
+
+	// Number of frames the warmup has been running and when it started, for the completion metric.
+	int32 NumFrames = 0;
+	double StartTime = 0.0;
+
+	// Last view location, used to detect teleports.
+	bool bHasViewLocation = false;
+	FVector LastViewLocation = FVector::ZeroVector;
+
+	// Actors already let through to this connection. Pointers are only used as keys.
+	TSet<FActorRepListType> AdmittedActors;
+
+	// Admitted actors gathered this frame, handed to the connection by reference.
+	FActorRepListRefView ActorList;
 };
 
 // Custom replication graph node that extends the base class for handling
@@ -227,9 +553,105 @@ public:
 	// Resets internal state when the game world is reset (e.g. level transition).
 	void ResetGameWorldState();
 
+	// Adds or removes a replication group (team, squad) this connection belongs to.
+	void AddReplicationGroup(int32 GroupId);
+	void RemoveReplicationGroup(int32 GroupId);
+
+	// Returns the replication groups this connection belongs to.
+	const TArray<int32, TInlineAllocator<4>>& GetReplicationGroups() const { return ReplicationGroups; }
+
+	// Starts pacing the initial replication of spatialized actors to this connection.
+	void BeginJoinWarmup();
+
+	// Join warmup state, owned by this connection and driven by the grid node.
+	FDAJoinWarmupState JoinWarmup;
+
+	// True if this is the connection of server-side replay recording using the replay profile.
+	// It gathers UMyReplicationGraph::ReplayActorLists instead of the grid and streaming-level lists.
+	bool bReplayConnection = false;
+
 protected:
 
 	// Stores the names of streaming levels that are currently visible to the client.
 	// Used to ensure that actors from these levels are included in replication for this connection.
 	TArray<FName, TInlineAllocator<64>> AlwaysRelevantStreamingLevels;
+
+	// Actors of streaming levels with dormancy actors that still need replicating to this connection, rebuilt every gather.
+	// Dormant and never-woken DORM_Initial actors are left out so the graph creates no actor info for them.
+	FActorRepListRefView StreamingLevelActorList;
+
+	// Replication groups this connection belongs to.
+	// Kept across world resets, the game is responsible for updating team and squad membership.
+	TArray<int32, TInlineAllocator<4>> ReplicationGroups;
+
+	// Gathers the whole-map replay lists on every ReplayGatherPeriod-th frame.
+	void GatherReplayActorLists(const FConnectionGatherActorListParameters& Params, UMyReplicationGraph& RepGraph);
+};
+
+// Global node that keeps one actor list per replication group (team or squad).
+// Actors with the RelevantGroup policy are stored in the list of their group, and every connection
+// gets the lists of the groups it belongs to by reference, so no per-connection filtering is needed.
+
+UCLASS()
+class UDAReplicationGraphNode_GroupRelevancy : public UReplicationGraphNode
+{
+public:
+
+	GENERATED_BODY()
+
+	// Adds the actor to the list of the group returned by AGroupRelevantActor::GetReplicationGroup().
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	// Removes the actor from whichever group list it is in.
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+
+	// Clears all group lists when the game world is reset.
+	virtual void NotifyResetAllNetworkActors() override;
+
+	// Adds the actor lists of every group this connection belongs to.
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	// Moves an already routed actor from one group list to another.
+	// INDEX_NONE as the new group removes it from all connections.
+	void MoveGroupActor(AActor* Actor, int32 OldGroupId, int32 NewGroupId);
+
+protected:
+
+	// Actor lists keyed by replication group id.
+	TMap<int32, FDAPooledActorList> GroupActorLists;
+};
+
+// Spatial grid node that paces initial replication for connections that are warming up.
+// For those connections the grid gathers into a scratch list, the actors are sorted by distance
+// to the viewers, and only a limited number of actors without an open channel are let through per frame.
+// Other connections use the regular grid gather.
+
+UCLASS()
+class UDAReplicationGraphNode_GridSpatialization2D : public UReplicationGraphNode_GridSpatialization2D
+{
+public:
+
+	GENERATED_BODY()
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	// Join warmup settings, copied from the graph config in InitGlobalGraphNodes().
+	int32 WarmupChannelBudgetPerFrame = 0;
+	int32 WarmupMaxFrames = 0;
+	float WarmupTeleportDistance = 0.f;
+
+	// Returns the completion metrics of all join warmups so far.
+	// Also published per warmup as the CSV stats RepGraphJoinWarmupFrames and RepGraphJoinWarmupSeconds.
+	const FDAJoinWarmupStats& GetWarmupStats() const { return WarmupStats; }
+
+protected:
+
+	FDAJoinWarmupStats WarmupStats;
+
+	// Gathers the paced actor list for a connection that is warming up.
+	void GatherWarmupActorLists(const FConnectionGatherActorListParameters& Params, UDAReplicationGraphNode_AlwaysRelevant_ForConnection& ConnectionNode);
+
+	// Scratch lists the grid gathers into for warming up connections.
+	// Reset but never freed, so the gather does not allocate once it has seen the largest frame.
+	FGatheredReplicationActorLists WarmupCandidateLists;
 };
\ No newline at end of file
@@ -0,0 +1,270 @@
+// Copyright (c) 2025 Aida Drogan, SilverCord-VR Studio
+
+#include "RepGraphSoakDirector.h"
+#include "DynamicRepActor.h"
+#include "StaticRepActor.h"
+#include "DormantRepActor.h"
+#include "RelevantAllConnectionsActor.h"
+#include "Engine/LevelStreamingDynamic.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/CommandLine.h"
+#include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
+
+// Sets default values
+ARepGraphSoakDirector::ARepGraphSoakDirector()
+{
+	// Only ticks while driving a bot pawn.
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	bReplicates = true;
+	bAlwaysRelevant = true;
+
+	DynamicActorClass = ADynamicRepActor::StaticClass();
+	StaticActorClass = AStaticRepActor::StaticClass();
+	DormantActorClass = ADormantRepActor::StaticClass();
+	RelevantAllActorClass = ARelevantAllConnectionsActor::StaticClass();
+}
+
+void ARepGraphSoakDirector::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ARepGraphSoakDirector, LoadedStreamingLevels);
+}
+
+// Called when the game starts or when spawned
+void ARepGraphSoakDirector::BeginPlay()
+{
+	Super::BeginPlay();
+
+	CreateStreamingLevels();
+
+	if (HasAuthority())
+	{
+		RandomStream.Initialize(RandomSeed);
+		SpawnActors();
+
+		// Every instance starts loaded, the timer then keeps toggling them.
+		LoadedStreamingLevels = StreamingLevelInstances.Num() >= 32 ? -1 : (1 << StreamingLevelInstances.Num()) - 1;
+		ApplyLoadedStreamingLevels();
+
+		if (StreamingLevelInstances.Num() > 0 && StreamingInterval > 0.f)
+		{
+			GetWorldTimerManager().SetTimer(StreamingTimer, this, &ARepGraphSoakDirector::ToggleRandomStreamingLevel, StreamingInterval, true);
+		}
+		if (ChurnInterval > 0.f)
+		{
+			GetWorldTimerManager().SetTimer(ChurnTimer, this, &ARepGraphSoakDirector::Churn, ChurnInterval, true);
+		}
+	}
+	else
+	{
+		// LoadedStreamingLevels may have been received before the instances existed.
+		ApplyLoadedStreamingLevels();
+
+		if (FParse::Param(FCommandLine::Get(), TEXT("RepGraphSoakBot")))
+		{
+			// Bots are seeded differently so they spread over the map.
+			BotRandomStream.GenerateNewSeed();
+			SetActorTickEnabled(true);
+		}
+	}
+}
+
+void ARepGraphSoakDirector::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+// Called every frame
+void ARepGraphSoakDirector::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	APawn* Pawn = PlayerController != nullptr ? PlayerController->GetPawn() : nullptr;
+	if (Pawn == nullptr)
+	{
+		return;
+	}
+
+	// Walks to a random point and picks the next one when it gets there or gets stuck for too long.
+	BotTargetTimeLeft -= DeltaTime;
+	const FVector ToTarget = BotTarget - Pawn->GetActorLocation();
+	if (BotTargetTimeLeft <= 0.f || ToTarget.SizeSquared2D() < FMath::Square(200.f))
+	{
+		BotTarget = GetRandomLocation(BotRandomStream);
+		BotTargetTimeLeft = BotRandomStream.FRandRange(10.f, 60.f);
+		return;
+	}
+
+	Pawn->AddMovementInput(ToTarget.GetSafeNormal2D());
+}
+
+void ARepGraphSoakDirector::OnRep_LoadedStreamingLevels()
+{
+	ApplyLoadedStreamingLevels();
+}
+
+void ARepGraphSoakDirector::OnStreamingLevelShown()
+{
+	for (int32 Index = 0; Index < StreamingLevelInstances.Num(); ++Index)
+	{
+		ULevelStreamingDynamic* LevelInstance = StreamingLevelInstances[Index];
+		ULevel* Level = LevelInstance != nullptr ? LevelInstance->GetLoadedLevel() : nullptr;
+		if (Level == nullptr || !LevelInstance->IsLevelVisible() || PopulatedLevels[Index].Get() == Level)
+		{
+			continue;
+		}
+
+		PopulatedLevels[Index] = Level;
+		for (int32 ActorIndex = 0; ActorIndex < NumRelevantAllActorsPerStreamingLevel; ++ActorIndex)
+		{
+			SpawnSoakActor(RelevantAllActorClass, Level);
+		}
+	}
+}
+
+void ARepGraphSoakDirector::SpawnActors()
+{
+	for (int32 Index = 0; Index < NumDynamicActors; ++Index)
+	{
+		if (AActor* Actor = SpawnSoakActor(DynamicActorClass, nullptr))
+		{
+			DynamicActors.Add(Actor);
+		}
+	}
+
+	for (int32 Index = 0; Index < NumStaticActors; ++Index)
+	{
+		if (AActor* Actor = SpawnSoakActor(StaticActorClass, nullptr))
+		{
+			DormantActors.Add(Actor);
+		}
+	}
+
+	for (int32 Index = 0; Index < NumDormantActors; ++Index)
+	{
+		if (AActor* Actor = SpawnSoakActor(DormantActorClass, nullptr))
+		{
+			Actor->SetNetDormancy(DORM_DormantAll);
+			DormantActors.Add(Actor);
+		}
+	}
+
+	for (int32 Index = 0; Index < NumRelevantAllActors; ++Index)
+	{
+		SpawnSoakActor(RelevantAllActorClass, nullptr);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Soak director spawned %d dynamic, %d static and dormant, %d relevant to all actors"),
+		DynamicActors.Num(), DormantActors.Num(), NumRelevantAllActors);
+}
+
+void ARepGraphSoakDirector::CreateStreamingLevels()
+{
+	if (StreamingLevel.IsNull())
+	{
+		return;
+	}
+
+	const int32 NumInstances = FMath::Clamp(NumStreamingLevels, 0, 32);
+	for (int32 Index = 0; Index < NumInstances; ++Index)
+	{
+		// The instances are laid out on a row through the soak area, and the server and the clients
+		// must use the same package name for the server to match the client's visibility updates.
+		const FString InstanceName = FString::Printf(TEXT("%s_RepGraphSoak_%d"), *StreamingLevel.GetLongPackageName(), Index);
+		const FVector Location = GetActorLocation() + FVector(-AreaExtent + (2.f * AreaExtent * (Index + 0.5f)) / NumInstances, 0.f, 0.f);
+
+		bool bSuccess = false;
+		ULevelStreamingDynamic* LevelInstance = ULevelStreamingDynamic::LoadLevelInstanceBySoftObjectPtr(this, StreamingLevel, Location, FRotator::ZeroRotator, bSuccess, InstanceName);
+		if (!bSuccess || LevelInstance == nullptr)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Soak director could not create level instance %s"), *InstanceName);
+			continue;
+		}
+
+		if (HasAuthority())
+		{
+			LevelInstance->OnLevelShown.AddDynamic(this, &ARepGraphSoakDirector::OnStreamingLevelShown);
+		}
+		StreamingLevelInstances.Add(LevelInstance);
+		PopulatedLevels.Add(nullptr);
+	}
+}
+
+void ARepGraphSoakDirector::ApplyLoadedStreamingLevels()
+{
+	for (int32 Index = 0; Index < StreamingLevelInstances.Num(); ++Index)
+	{
+		const bool bLoaded = (LoadedStreamingLevels & (1 << Index)) != 0;
+		if (ULevelStreamingDynamic* LevelInstance = StreamingLevelInstances[Index])
+		{
+			LevelInstance->SetShouldBeLoaded(bLoaded);
+			LevelInstance->SetShouldBeVisible(bLoaded);
+		}
+	}
+}
+
+void ARepGraphSoakDirector::ToggleRandomStreamingLevel()
+{
+	const int32 Index = RandomStream.RandHelper(StreamingLevelInstances.Num());
+	LoadedStreamingLevels ^= 1 << Index;
+	ApplyLoadedStreamingLevels();
+}
+
+// Wakes dormant and static actors so they replicate once more, and moves dynamic actors between grid cells.
+void ARepGraphSoakDirector::Churn()
+{
+	for (int32 Index = 0; Index < NumWokenActorsPerChurn && DormantActors.Num() > 0; ++Index)
+	{
+		AActor* Actor = DormantActors[RandomStream.RandHelper(DormantActors.Num())];
+		if (AStaticRepActor* StaticActor = Cast<AStaticRepActor>(Actor))
+		{
+			StaticActor->MarkReplicatedStateDirty();
+		}
+		else if (Actor != nullptr)
+		{
+			Actor->FlushNetDormancy();
+		}
+	}
+
+	const FVector Center = GetActorLocation();
+	for (int32 Index = 0; Index < NumMovedActorsPerChurn && DynamicActors.Num() > 0; ++Index)
+	{
+		AActor* Actor = DynamicActors[RandomStream.RandHelper(DynamicActors.Num())];
+		if (Actor == nullptr)
+		{
+			continue;
+		}
+
+		FVector Location = Actor->GetActorLocation() + FVector(RandomStream.FRandRange(-MoveDistance, MoveDistance), RandomStream.FRandRange(-MoveDistance, MoveDistance), 0.f);
+		Location.X = FMath::Clamp(Location.X, Center.X - AreaExtent, Center.X + AreaExtent);
+		Location.Y = FMath::Clamp(Location.Y, Center.Y - AreaExtent, Center.Y + AreaExtent);
+		Actor->SetActorLocation(Location);
+	}
+}
+
+AActor* ARepGraphSoakDirector::SpawnSoakActor(UClass* Class, ULevel* Level)
+{
+	if (Class == nullptr)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.OverrideLevel = Level;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	return GetWorld()->SpawnActor<AActor>(Class, GetRandomLocation(RandomStream), FRotator::ZeroRotator, SpawnParams);
+}
+
+FVector ARepGraphSoakDirector::GetRandomLocation(FRandomStream& Stream) const
+{
+	return GetActorLocation() + FVector(Stream.FRandRange(-AreaExtent, AreaExtent), Stream.FRandRange(-AreaExtent, AreaExtent), 0.f);
+}
@@ -0,0 +1,163 @@
+// Copyright (c) 2025 Aida Drogan, SilverCord-VR Studio
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "RepGraphSoakDirector.generated.h"
+
+class ADynamicRepActor;
+class AStaticRepActor;
+class ADormantRepActor;
+class ARelevantAllConnectionsActor;
+class ULevelStreamingDynamic;
+
+// Drives a replication graph soak run, see Scripts/run_repgraph_soak.sh.
+// Place one in an otherwise empty map. On the server it fills the map with the four test actor types,
+// streams level instances in and out and keeps waking and moving actors. Clients started with
+// -RepGraphSoakBot drive their pawn around the map. Every client mirrors the streamed level instances,
+// so the server sees the same level visibility changes it would see from real players.
+UCLASS()
+class REPGRAPHTEST_API ARepGraphSoakDirector : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this actor's properties
+	ARepGraphSoakDirector();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	// Called every frame, only while driving a bot pawn.
+	virtual void Tick(float DeltaTime) override;
+
+	// Seed of the server's spawn and churn decisions, so runs are repeatable.
+	UPROPERTY(EditAnywhere, Category = "Soak")
+	int32 RandomSeed = 1;
+
+	// Half size of the square area (in UU) around the director the actors are spawned in and bots walk in.
+	UPROPERTY(EditAnywhere, Category = "Soak")
+	float AreaExtent = 50000.f;
+
+	UPROPERTY(EditAnywhere, Category = "Soak|Actors")
+	TSubclassOf<ADynamicRepActor> DynamicActorClass;
+
+	UPROPERTY(EditAnywhere, Category = "Soak|Actors")
+	int32 NumDynamicActors = 2000;
+
+	UPROPERTY(EditAnywhere, Category = "Soak|Actors")
+	TSubclassOf<AStaticRepActor> StaticActorClass;
+
+	UPROPERTY(EditAnywhere, Category = "Soak|Actors")
+	int32 NumStaticActors = 4000;
+
+	// Spawned actors of this class are made DORM_DormantAll.
+	UPROPERTY(EditAnywhere, Category = "Soak|Actors")
+	TSubclassOf<ADormantRepActor> DormantActorClass;
+
+	UPROPERTY(EditAnywhere, Category = "Soak|Actors")
+	int32 NumDormantActors = 2000;
+
+	UPROPERTY(EditAnywhere, Category = "Soak|Actors")
+	TSubclassOf<ARelevantAllConnectionsActor> RelevantAllActorClass;
+
+	// Spawned in the persistent level.
+	UPROPERTY(EditAnywhere, Category = "Soak|Actors")
+	int32 NumRelevantAllActors = 50;
+
+	// Spawned into every streamed level instance each time it is shown on the server.
+	UPROPERTY(EditAnywhere, Category = "Soak|Actors")
+	int32 NumRelevantAllActorsPerStreamingLevel = 20;
+
+	// Level that is instanced NumStreamingLevels times. Leave empty to run without level streaming.
+	UPROPERTY(EditAnywhere, Category = "Soak|Streaming")
+	TSoftObjectPtr<UWorld> StreamingLevel;
+
+	// At most 32, one bit of LoadedStreamingLevels each.
+	UPROPERTY(EditAnywhere, Category = "Soak|Streaming", meta = (ClampMin = "0", ClampMax = "32"))
+	int32 NumStreamingLevels = 8;
+
+	// Seconds between two level instances being toggled between loaded and unloaded.
+	UPROPERTY(EditAnywhere, Category = "Soak|Streaming")
+	float StreamingInterval = 20.f;
+
+	// Seconds between two churn steps on the server.
+	UPROPERTY(EditAnywhere, Category = "Soak|Churn")
+	float ChurnInterval = 1.f;
+
+	// Static and dormant actors woken up (flushed) per churn step.
+	UPROPERTY(EditAnywhere, Category = "Soak|Churn")
+	int32 NumWokenActorsPerChurn = 20;
+
+	// Dynamic actors moved per churn step.
+	UPROPERTY(EditAnywhere, Category = "Soak|Churn")
+	int32 NumMovedActorsPerChurn = 200;
+
+	// Longest distance (in UU) a dynamic actor moves in one churn step.
+	UPROPERTY(EditAnywhere, Category = "Soak|Churn")
+	float MoveDistance = 2000.f;
+
+protected:
+	// Bit N is set while level instance N is loaded and visible on the server.
+	UPROPERTY(ReplicatedUsing = OnRep_LoadedStreamingLevels)
+	int32 LoadedStreamingLevels = 0;
+
+	UFUNCTION()
+	void OnRep_LoadedStreamingLevels();
+
+	// Spawns RelevantAllConnections actors into level instances that were shown since the last call.
+	UFUNCTION()
+	void OnStreamingLevelShown();
+
+private:
+	void SpawnActors();
+
+	// Creates the level instances with names that are the same on the server and every client.
+	void CreateStreamingLevels();
+
+	// Loads and shows the level instances whose bit is set, hides and unloads the others.
+	void ApplyLoadedStreamingLevels();
+
+	void ToggleRandomStreamingLevel();
+
+	void Churn();
+
+	AActor* SpawnSoakActor(UClass* Class, ULevel* Level);
+
+	FVector GetRandomLocation(FRandomStream& Stream) const;
+
+	// Server side.
+	FRandomStream RandomStream;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AActor>> DynamicActors;
+
+	// Static and dormant actors, both woken with FlushNetDormancy().
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AActor>> DormantActors;
+
+	// Level each instance was last populated with, so it is only populated once per load.
+	TArray<TWeakObjectPtr<ULevel>> PopulatedLevels;
+
+	FTimerHandle StreamingTimer;
+
+	FTimerHandle ChurnTimer;
+
+	// Both sides.
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ULevelStreamingDynamic>> StreamingLevelInstances;
+
+	// Bot side.
+	FRandomStream BotRandomStream;
+
+	FVector BotTarget = FVector::ZeroVector;
+
+	float BotTargetTimeLeft = 0.f;
+};
@@ -11,6 +11,10 @@ AStaticRepActor::AStaticRepActor()
 	SetReplicateMovement(false);
 	PrimaryActorTick.bCanEverTick = false;
 
+	// Replicate once to each connection, then stay dormant until MarkReplicatedStateDirty() is called.
+	// Dormant static actors are dropped from the grid cell lists of connections they are dormant on.
+	NetDormancy = DORM_DormantAll;
+
 }
 
 // Called when the game starts or when spawned
@@ -25,4 +29,14 @@ void AStaticRepActor::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+}
+
+// Flushes dormancy so the current state is replicated once more.
+// The actor goes back to dormant on each connection after the update is sent.
+void AStaticRepActor::MarkReplicatedStateDirty()
+{
+	if (HasAuthority())
+	{
+		FlushNetDormancy();
+	}
 }
\ No newline at end of file
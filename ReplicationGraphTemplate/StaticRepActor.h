@@ -23,4 +23,9 @@ public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
+	// Static actors go dormant on each connection once their initial state has been replicated.
+	// Call this on the server after changing a replicated property so the change is sent to clients.
+	UFUNCTION(BlueprintCallable, Category = "Replication")
+	void MarkReplicatedStateDirty();
+
 };
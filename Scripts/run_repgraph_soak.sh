@@ -0,0 +1,157 @@
+#!/usr/bin/env bash
+# Copyright (c) 2025 Aida Drogan, SilverCord-VR Studio
+#
+# Runs a replication graph soak test on one Linux machine: a headless dedicated server with
+# -RepGraphSoak plus headless bot clients connected over loopback. Waits for the server to
+# finish its run, stops the bots and exits with the server's status (0 = pass, 1 = fail).
+
+set -u
+
+usage()
+{
+	cat <<USAGE
+Usage: $(basename "$0") --server <ServerBinary> --client <ClientBinary> --map <Map> --bots <N> --duration <Seconds> [options]
+
+Options:
+  --port <Port>            Server port (default 7777)
+  --log-dir <Dir>          Directory for server and bot logs (default ./SoakLogs)
+  --connect-delay <Sec>    Seconds to wait for the server before starting bots (default 30)
+  --bot-delay <Sec>        Seconds between two bot launches (default 0.5)
+  --grace <Sec>            Extra seconds after --duration before the server is killed (default 300)
+  --client-args "<Args>"   Extra arguments for every bot client (default -RepGraphSoakBot)
+
+The map must contain a RepGraphSoakDirector. It spawns the test actors and streams levels on the
+server, and drives the pawn of every client started with -RepGraphSoakBot.
+
+Exit codes: server status (0 pass, 1 fail), 2 server did not finish in time,
+3 bots exited while the server was still running, 64 usage error.
+USAGE
+}
+
+SERVER=""
+CLIENT=""
+MAP=""
+BOTS=""
+DURATION=""
+PORT=7777
+LOG_DIR="./SoakLogs"
+CONNECT_DELAY=30
+BOT_DELAY=0.5
+GRACE=300
+CLIENT_ARGS="-RepGraphSoakBot"
+
+while [ $# -gt 0 ]; do
+	case "$1" in
+		--server) SERVER="$2"; shift 2 ;;
+		--client) CLIENT="$2"; shift 2 ;;
+		--map) MAP="$2"; shift 2 ;;
+		--bots) BOTS="$2"; shift 2 ;;
+		--duration) DURATION="$2"; shift 2 ;;
+		--port) PORT="$2"; shift 2 ;;
+		--log-dir) LOG_DIR="$2"; shift 2 ;;
+		--connect-delay) CONNECT_DELAY="$2"; shift 2 ;;
+		--bot-delay) BOT_DELAY="$2"; shift 2 ;;
+		--grace) GRACE="$2"; shift 2 ;;
+		--client-args) CLIENT_ARGS="$2"; shift 2 ;;
+		-h|--help) usage; exit 0 ;;
+		*) echo "Unknown argument: $1" >&2; usage >&2; exit 64 ;;
+	esac
+done
+
+if [ -z "$SERVER" ] || [ -z "$CLIENT" ] || [ -z "$MAP" ] || [ -z "$BOTS" ] || [ -z "$DURATION" ]; then
+	usage >&2
+	exit 64
+fi
+
+mkdir -p "$LOG_DIR"
+LOG_DIR="$(cd "$LOG_DIR" && pwd)"
+
+SERVER_PID=""
+BOT_PIDS=()
+
+# Every process runs in its own session, so launcher scripts are stopped together with the game binary.
+kill_tree()
+{
+	kill -- "-$1" 2>/dev/null || kill "$1" 2>/dev/null
+}
+
+cleanup()
+{
+	for PID in "${BOT_PIDS[@]}"; do
+		kill_tree "$PID"
+	done
+	if [ -n "$SERVER_PID" ]; then
+		kill_tree "$SERVER_PID"
+	fi
+	wait 2>/dev/null
+}
+trap cleanup EXIT
+trap 'exit 130' INT TERM
+
+echo "Starting server: $MAP, $DURATION s, port $PORT"
+setsid "$SERVER" "$MAP" -server -log -unattended -nosound -port="$PORT" \
+	-RepGraphSoak -RepGraphSoakDuration="$DURATION" \
+	-abslog="$LOG_DIR/Server.log" >/dev/null 2>&1 &
+SERVER_PID=$!
+
+sleep "$CONNECT_DELAY"
+if ! kill -0 "$SERVER_PID" 2>/dev/null; then
+	wait "$SERVER_PID"
+	echo "Server exited before the bots were started (status $?)" >&2
+	exit 2
+fi
+
+echo "Starting $BOTS bots"
+for i in $(seq 1 "$BOTS"); do
+	# shellcheck disable=SC2086
+	setsid "$CLIENT" "127.0.0.1:$PORT" -nullrhi -nosound -unattended $CLIENT_ARGS \
+		-abslog="$LOG_DIR/Bot_$i.log" >/dev/null 2>&1 &
+	BOT_PIDS+=($!)
+	sleep "$BOT_DELAY"
+done
+
+# Wait for the server's verdict, killing it if it overruns the requested duration.
+# Bots are checked while the server is still running, so bots that stop because the server
+# shut down are not counted as early exits.
+START=$(date +%s)
+DEADLINE=$((START + ${DURATION%.*} + GRACE))
+declare -A BOT_DEAD=()
+NUM_DEAD=0
+FIRST_DEAD=""
+while kill -0 "$SERVER_PID" 2>/dev/null; do
+	NOW=$(date +%s)
+	for i in "${!BOT_PIDS[@]}"; do
+		if [ -z "${BOT_DEAD[$i]:-}" ] && ! kill -0 "${BOT_PIDS[$i]}" 2>/dev/null; then
+			BOT_DEAD[$i]=$NOW
+			NUM_DEAD=$((NUM_DEAD + 1))
+			if [ -z "$FIRST_DEAD" ]; then
+				FIRST_DEAD="bot $((i + 1)) after $((NOW - START)) s (log: $LOG_DIR/Bot_$((i + 1)).log)"
+				echo "First bot exited early: $FIRST_DEAD" >&2
+			fi
+		fi
+	done
+
+	if [ "$NOW" -ge "$DEADLINE" ]; then
+		echo "Server did not finish within $DURATION s + $GRACE s grace, killing it" >&2
+		kill_tree "$SERVER_PID"
+		wait "$SERVER_PID" 2>/dev/null
+		SERVER_PID=""
+		exit 2
+	fi
+	sleep 5
+done
+
+wait "$SERVER_PID"
+STATUS=$?
+SERVER_PID=""
+
+grep -E "Soak (finished|PASSED|FAILED)" "$LOG_DIR/Server.log" 2>/dev/null
+echo "Server exited with status $STATUS, $NUM_DEAD of $BOTS bots exited early. Logs: $LOG_DIR"
+if [ -n "$FIRST_DEAD" ]; then
+	echo "First early exit: $FIRST_DEAD"
+fi
+
+if [ "$STATUS" -eq 0 ] && [ "$NUM_DEAD" -gt 0 ]; then
+	exit 3
+fi
+exit "$STATUS"